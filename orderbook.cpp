@@ -9,12 +9,22 @@
 #include <vector>
 #include <chrono>
 #include <queue>
+#include <algorithm>
+#include <limits>
+#include <random>
 
 enum class Side { Buy, Sell };
 enum class Status { Used, Free };
 
 constexpr size_t MAX_ORDERS = 2'000;
 
+// estimateSweep sums SWEEP_BLOCK price levels at a time before checking the remaining quantity
+constexpr int SWEEP_LANES = 4;
+constexpr int SWEEP_BLOCK = 32;
+// relative tolerance for the drift between a level's summed volume and its orders' volumes
+// a level within this tolerance of the remaining quantity is walked order by order instead
+constexpr double SWEEP_EPSILON = 1e-9;
+
 struct Order {
     int owner_id;
     int order_id;
@@ -24,6 +34,36 @@ struct Order {
     Side side;
 };
 
+// result of walking the opposite side of the book for a hypothetical order
+struct SweepEstimate {
+    double vwap = 0.0;          // volume weighted average price of the fillable quantity
+    double worst_price = 0.0;   // least favourable order price that would be filled
+    double fillable = 0.0;      // quantity that could be filled within the limit
+    int levels = 0;             // number of non-empty price levels consumed
+};
+
+// sum SWEEP_BLOCK consecutive level volumes and notionals
+// the lanes are independent accumulators so the floating point sums can be vectorized without -ffast-math
+void sumBlock(const double* volume, const double* notional, double& block_volume, double& block_notional) {
+    double vol_acc[SWEEP_LANES] = {};
+    double px_acc[SWEEP_LANES] = {};
+    for (int b = 0; b < SWEEP_BLOCK; b += SWEEP_LANES) {
+        for (int k = 0; k < SWEEP_LANES; ++k) {
+            vol_acc[k] += volume[b + k];
+            px_acc[k] += notional[b + k];
+        }
+    }
+
+    double volume_sum = 0.0;
+    double notional_sum = 0.0;
+    for (int k = 0; k < SWEEP_LANES; ++k) {
+        volume_sum += vol_acc[k];
+        notional_sum += px_acc[k];
+    }
+    block_volume = volume_sum;
+    block_notional = notional_sum;
+}
+
 struct OrderNode {
     Order order;
     int next = -1;
@@ -97,6 +137,14 @@ class OrderPool {
                 return pool[idx];
             }
         }
+
+        const OrderNode& operator[](int idx) const {
+            if (pool[idx].status != Status::Used) {
+                throw std::runtime_error("Index is free");
+            } else {
+                return pool[idx];
+            }
+        }
 };
 
 class PriceLevel {
@@ -182,11 +230,11 @@ class PriceLevel {
             }
         }
 
-        int head() {
+        int head() const {
             return m_head;
         }
 
-        double price() {
+        double price() const {
             return m_price;
         }
 
@@ -210,6 +258,19 @@ class OrderBook {
         int num_price_levels;
         std::vector<PriceLevel> asks;
         std::vector<PriceLevel> bids;
+        // aggregates for each price level, kept in sync with the price level queues
+        // stored contiguously so the book can be scanned without walking the order lists
+        // volume = total resting volume, notional = sum of volume * order price, orders = number of resting orders
+        std::vector<double> ask_volume;
+        std::vector<double> bid_volume;
+        std::vector<double> ask_notional;
+        std::vector<double> bid_notional;
+        std::vector<int> ask_orders;
+        std::vector<int> bid_orders;
+        // lowest non-empty ask level and highest non-empty bid level
+        // best_ask = num_price_levels if there are no asks, best_bid = -1 if there are no bids
+        int best_ask;
+        int best_bid;
         std::unordered_map<int, int> order_lookup;
         int order_count = 0;
         OrderPool pool;
@@ -233,6 +294,64 @@ class OrderBook {
                 asks.push_back(PriceLevel(price));
                 bids.push_back(PriceLevel(price));
             }
+
+            ask_volume.assign(num_price_levels, 0.0);
+            bid_volume.assign(num_price_levels, 0.0);
+            ask_notional.assign(num_price_levels, 0.0);
+            bid_notional.assign(num_price_levels, 0.0);
+            ask_orders.assign(num_price_levels, 0);
+            bid_orders.assign(num_price_levels, 0);
+            best_ask = num_price_levels;
+            best_bid = -1;
+        }
+
+        // add a resting order to the level aggregates and update the best price
+        void addToLevel(int price_idx, Order& order) {
+            if (order.side == Side::Buy) {
+                bid_volume[price_idx] += order.volume;
+                bid_notional[price_idx] += order.volume * order.price;
+                bid_orders[price_idx]++;
+                best_bid = std::max(best_bid, price_idx);
+            } else {
+                ask_volume[price_idx] += order.volume;
+                ask_notional[price_idx] += order.volume * order.price;
+                ask_orders[price_idx]++;
+                best_ask = std::min(best_ask, price_idx);
+            }
+        }
+
+        // remove part of a resting order's volume from the level aggregates
+        void fillAtLevel(int price_idx, Order& order, double volume) {
+            std::vector<double>& level_volume = (order.side == Side::Buy) ? bid_volume : ask_volume;
+            std::vector<double>& level_notional = (order.side == Side::Buy) ? bid_notional : ask_notional;
+            level_volume[price_idx] -= volume;
+            level_notional[price_idx] -= volume * order.price;
+        }
+
+        // remove a resting order from the level aggregates, call before the order is freed from the pool
+        void removeFromLevel(int price_idx, Order& order) {
+            std::vector<int>& level_orders = (order.side == Side::Buy) ? bid_orders : ask_orders;
+            fillAtLevel(price_idx, order, order.volume);
+            level_orders[price_idx]--;
+
+            // reset the aggregates once the level is empty so rounding errors do not accumulate
+            if (level_orders[price_idx] == 0) {
+                if (order.side == Side::Buy) {
+                    bid_volume[price_idx] = 0.0;
+                    bid_notional[price_idx] = 0.0;
+                    // move the best bid down to the next non-empty level
+                    while (best_bid >= 0 && bid_orders[best_bid] == 0) {
+                        best_bid--;
+                    }
+                } else {
+                    ask_volume[price_idx] = 0.0;
+                    ask_notional[price_idx] = 0.0;
+                    // move the best ask up to the next non-empty level
+                    while (best_ask < num_price_levels && ask_orders[best_ask] == 0) {
+                        best_ask++;
+                    }
+                }
+            }
         }
 
 
@@ -260,6 +379,7 @@ class OrderBook {
 
                     // push this order to the back of the queue at the price level
                     int pool_idx = side[price_idx].pushBack(pool, order);
+                    addToLevel(price_idx, order);
 
                     // store the pool idx in the order lookup table
                     order_lookup[order.order_id] = pool_idx;
@@ -285,6 +405,7 @@ class OrderBook {
 
             // remove the order node with this pool index from the price level queue
             std::vector<PriceLevel>& orders = (pool[pool_idx].order.side == Side::Buy) ? bids : asks;
+            removeFromLevel(price_idx, pool[pool_idx].order);
             orders[price_idx].remove(pool, pool_idx);
         }
 
@@ -315,6 +436,7 @@ class OrderBook {
                             
                             // decrease the volume
                             order.volume -= opp_order.volume;
+                            removeFromLevel(price_idx, opp_order);
                             
                             // delete the opposite order from the queue
                             opp[price_idx].popFront(pool);
@@ -328,6 +450,7 @@ class OrderBook {
                                 << ", price=" << opp_order.price << "\n";
                             
                             // remove this volume from the opposite order
+                            fillAtLevel(price_idx, opp_order, order.volume);
                             opp_order.volume -= order.volume;
 
                             // set the order volume to zero, this will trigger the loop between price levels to stop
@@ -343,6 +466,159 @@ class OrderBook {
             }
         }
 
+        // estimate the cost of sweeping qty from the opposite side of the book up to the limit price
+        // read-only: uses the level aggregates for whole levels and walks only the queue of the last level touched,
+        // so the result is the same as the fills match would produce at each order's own price
+        // pass limit = +inf for a buy or -inf for a sell to sweep without a limit, a NaN limit or qty fills nothing
+        // pass qty = +inf to get the total volume available up to the limit
+        SweepEstimate estimateSweep(Side side, double qty, double limit) const {
+            SweepEstimate est;
+            if (!(qty > 0) || std::isnan(limit)) {
+                return est;
+            }
+
+            const std::vector<PriceLevel>& opp = (side == Side::Buy) ? asks : bids;
+            const std::vector<double>& opp_volume = (side == Side::Buy) ? ask_volume : bid_volume;
+            const std::vector<double>& opp_notional = (side == Side::Buy) ? ask_notional : bid_notional;
+            const std::vector<int>& opp_orders = (side == Side::Buy) ? ask_orders : bid_orders;
+
+            // find the range of opposite price levels [lo, hi] that are within the limit, starting from the best price
+            // if side is buy, levels with price <= limit can be used
+            // if side is sell, levels with price >= limit can be used
+            int lo = 0;
+            int hi = num_price_levels - 1;
+            if (side == Side::Buy) {
+                if (limit < 0) {
+                    return est;
+                }
+                if (limit < max_price) {
+                    // clamp before correcting for rounding in the division so the bound agrees with the price comparison in match
+                    hi = std::min(static_cast<int>(limit / tick), num_price_levels - 1);
+                    while (hi + 1 < num_price_levels && opp[hi + 1].price() <= limit) {
+                        hi++;
+                    }
+                    while (hi >= 0 && opp[hi].price() > limit) {
+                        hi--;
+                    }
+                }
+                lo = best_ask;
+            } else {
+                if (limit >= max_price) {
+                    return est;
+                }
+                if (limit > 0) {
+                    lo = std::min(static_cast<int>(limit / tick), num_price_levels - 1);
+                    while (lo - 1 >= 0 && opp[lo - 1].price() >= limit) {
+                        lo--;
+                    }
+                    while (lo < num_price_levels && opp[lo].price() < limit) {
+                        lo++;
+                    }
+                }
+                hi = best_bid;
+            }
+            if (lo > hi) {
+                return est;
+            }
+
+            // step j counts levels in the order match would visit them
+            // if side is buy, lowest ask first; if side is sell, highest bid first
+            int n = hi - lo + 1;
+            double remaining = qty;
+            double filled = 0.0;
+            double notional = 0.0;
+            int last_idx = -1;
+            int j = 0;
+
+            // consume whole blocks of levels while the block cannot fill the remaining quantity
+            for ( ; j + SWEEP_BLOCK <= n; j += SWEEP_BLOCK) {
+                int base = (side == Side::Buy) ? (lo + j) : (hi - j - SWEEP_BLOCK + 1);
+                const double* v = opp_volume.data() + base;
+                const double* p = opp_notional.data() + base;
+                const int* c = opp_orders.data() + base;
+
+                double block_volume, block_notional;
+                sumBlock(v, p, block_volume, block_notional);
+
+                // the final level lies inside this block, finish level by level below
+                // the summed volumes drift from the order volumes, so a block that only just fits is also finished below
+                if (remaining - block_volume <= SWEEP_EPSILON * (filled + block_volume)) {
+                    break;
+                }
+
+                int block_levels = 0;
+                for (int b = 0; b < SWEEP_BLOCK; ++b) {
+                    block_levels += (c[b] != 0);
+                }
+
+                remaining -= block_volume;
+                filled += block_volume;
+                notional += block_notional;
+                est.levels += block_levels;
+            }
+
+            // the furthest non-empty level consumed by whole blocks
+            for (int m = j - 1; m >= 0 && est.levels > 0; --m) {
+                int price_idx = (side == Side::Buy) ? (lo + m) : (hi - m);
+                if (opp_orders[price_idx] != 0) {
+                    last_idx = price_idx;
+                    break;
+                }
+            }
+
+            // walk the remaining levels one at a time until the quantity is filled
+            // a level that cannot be taken whole, or only just can, is walked order by order in queue order, as match would fill it
+            bool walked_last = false;
+            for ( ; j < n && remaining > 0; ++j) {
+                int price_idx = (side == Side::Buy) ? (lo + j) : (hi - j);
+                if (opp_orders[price_idx] == 0) {
+                    continue;
+                }
+                est.levels++;
+                last_idx = price_idx;
+                if (remaining - opp_volume[price_idx] > SWEEP_EPSILON * (filled + opp_volume[price_idx])) {
+                    remaining -= opp_volume[price_idx];
+                    filled += opp_volume[price_idx];
+                    notional += opp_notional[price_idx];
+                    walked_last = false;
+                } else {
+                    walked_last = true;
+                    int head = opp[price_idx].head();
+                    est.worst_price = pool[head].order.price;
+                    for (int idx = head; idx != -1 && remaining > 0; idx = pool[idx].next) {
+                        const Order& opp_order = pool[idx].order;
+                        double take = std::min(opp_order.volume, remaining);
+                        remaining -= take;
+                        filled += take;
+                        notional += take * opp_order.price;
+                        est.worst_price = (side == Side::Buy) ? std::max(est.worst_price, opp_order.price) : std::min(est.worst_price, opp_order.price);
+                    }
+                    // what is left is the drift carried over from the summed levels, so the quantity is filled
+                    if (remaining <= SWEEP_EPSILON * filled) {
+                        remaining = 0.0;
+                    }
+                }
+            }
+
+            // if the side runs out first (including qty = +inf) then only the volume taken is fillable
+            est.fillable = (remaining == 0) ? qty : filled;
+            if (est.fillable > 0) {
+                est.vwap = notional / est.fillable;
+            }
+
+            // the worst price is in the last level touched, as order prices are truncated onto the levels
+            // if that level was taken whole then any of its orders may hold the worst price
+            if (last_idx >= 0 && walked_last == false) {
+                int head = opp[last_idx].head();
+                est.worst_price = pool[head].order.price;
+                for (int idx = head; idx != -1; idx = pool[idx].next) {
+                    double price = pool[idx].order.price;
+                    est.worst_price = (side == Side::Buy) ? std::max(est.worst_price, price) : std::min(est.worst_price, price);
+                }
+            }
+            return est;
+        }
+
         void print() {
             std::cout << "Buy orders:\n";
             for (int i = 0; i < num_price_levels; ++i) {
@@ -410,6 +686,240 @@ void test1() {
 }
 
 
+bool checkValue(const std::string& name, double got, double expected) {
+    bool ok = std::fabs(got - expected) <= 1e-9 * std::max(1.0, std::fabs(expected));
+    std::cout << (ok ? "PASS " : "FAIL ") << name << ": got=" << got << ", expected=" << expected << "\n";
+    return ok;
+}
+
+bool checkSweep(const std::string& name, SweepEstimate est, double vwap, double worst_price, int levels, double fillable) {
+    bool ok = checkValue(name + " vwap", est.vwap, vwap);
+    ok = checkValue(name + " worst_price", est.worst_price, worst_price) && ok;
+    ok = checkValue(name + " levels", est.levels, levels) && ok;
+    ok = checkValue(name + " fillable", est.fillable, fillable) && ok;
+    return ok;
+}
+
+// total volume and volume * price of the resting orders on one side, found by walking the price level queues
+void restingTotals(OrderBook& orderbook, Side side, double& volume, double& notional) {
+    std::vector<PriceLevel>& levels = (side == Side::Buy) ? orderbook.bids : orderbook.asks;
+    volume = 0.0;
+    notional = 0.0;
+    for (int i = 0; i < orderbook.num_price_levels; ++i) {
+        for (int idx = levels[i].head(); idx != -1; idx = orderbook.pool[idx].next) {
+            volume += orderbook.pool[idx].order.volume;
+            notional += orderbook.pool[idx].order.volume * orderbook.pool[idx].order.price;
+        }
+    }
+}
+
+// walk the opposite side order by order exactly as match fills it, without using the level aggregates
+SweepEstimate referenceSweep(OrderBook& orderbook, Side side, double qty, double limit) {
+    SweepEstimate est;
+    std::vector<PriceLevel>& opp = (side == Side::Buy) ? orderbook.asks : orderbook.bids;
+    double remaining = qty;
+    double filled = 0.0;
+    double notional = 0.0;
+    for (int i = 0; i < orderbook.num_price_levels && remaining > 0; ++i) {
+        int price_idx = (side == Side::Buy) ? i : (orderbook.num_price_levels - 1 - i);
+        double opp_price = opp[price_idx].price();
+        if ((side == Side::Buy && opp_price > limit) || (side == Side::Sell && opp_price < limit)) {
+            break;
+        }
+        if (opp[price_idx].isEmpty()) {
+            continue;
+        }
+        est.levels++;
+        est.worst_price = orderbook.pool[opp[price_idx].head()].order.price;
+        for (int idx = opp[price_idx].head(); idx != -1 && remaining > 0; idx = orderbook.pool[idx].next) {
+            const Order& opp_order = orderbook.pool[idx].order;
+            double take = std::min(opp_order.volume, remaining);
+            remaining -= take;
+            filled += take;
+            notional += take * opp_order.price;
+            est.worst_price = (side == Side::Buy) ? std::max(est.worst_price, opp_order.price) : std::min(est.worst_price, opp_order.price);
+        }
+    }
+    est.fillable = (remaining == 0) ? qty : filled;
+    if (est.fillable > 0) {
+        est.vwap = notional / est.fillable;
+    }
+    return est;
+}
+
+// run the order through match on a copy of the book and check the estimate against the fills
+bool checkSweepAgainstMatch(const std::string& name, OrderBook& orderbook, Side side, double qty, double limit) {
+    SweepEstimate est = orderbook.estimateSweep(side, qty, limit);
+
+    OrderBook copy = orderbook;
+    Side opp_side = (side == Side::Buy) ? Side::Sell : Side::Buy;
+    double volume_before, notional_before, volume_after, notional_after;
+    restingTotals(copy, opp_side, volume_before, notional_before);
+    copy.newOrder(0, limit, qty, side);
+    restingTotals(copy, opp_side, volume_after, notional_after);
+
+    double filled = volume_before - volume_after;
+    bool ok = checkValue(name + " fillable vs match", est.fillable, filled);
+    if (filled > 0) {
+        ok = checkValue(name + " vwap vs match", est.vwap, (notional_before - notional_after) / filled) && ok;
+    }
+    return ok;
+}
+
+bool sweepTest1() {
+    double tick = 0.01;
+    double max_price = 100.0;
+    double inf = std::numeric_limits<double>::infinity();
+    bool ok = true;
+
+    OrderBook orderbook(tick, max_price);
+
+    orderbook.newOrder(1, 50.0, 100, Side::Sell);
+    orderbook.newOrder(2, 50.0, 50, Side::Sell);
+    int ask_505 = orderbook.newOrder(3, 50.5, 200, Side::Sell);
+    orderbook.newOrder(4, 52.0, 300, Side::Sell);
+    orderbook.newOrder(5, 49.0, 80, Side::Buy);
+    orderbook.newOrder(6, 48.0, 120, Side::Buy);
+
+    std::cout << "\n";
+    orderbook.print();
+    std::cout << "\n";
+
+    // buy 250 without a limit: 150 @ 50.0 + 100 @ 50.5
+    ok = checkSweep("buy 250", orderbook.estimateSweep(Side::Buy, 250, inf), 50.2, 50.5, 2, 250) && ok;
+    ok = checkSweepAgainstMatch("buy 250 @ 99", orderbook, Side::Buy, 250, 99.0) && ok;
+
+    // buy 1000 limited to 51.0: only the levels at 50.0 and 50.5 are usable
+    ok = checkSweep("buy 1000 @ 51", orderbook.estimateSweep(Side::Buy, 1000, 51.0), 17600.0 / 350, 50.5, 2, 350) && ok;
+    ok = checkSweepAgainstMatch("buy 1000 @ 51", orderbook, Side::Buy, 1000, 51.0) && ok;
+
+    // sell 150 down to 48.0: 80 @ 49.0 + 70 @ 48.0
+    ok = checkSweep("sell 150 @ 48", orderbook.estimateSweep(Side::Sell, 150, 48.0), 7280.0 / 150, 48.0, 2, 150) && ok;
+    ok = checkSweepAgainstMatch("sell 150 @ 48", orderbook, Side::Sell, 150, 48.0) && ok;
+
+    // limits outside the book
+    ok = checkSweep("sell 10 @ 150", orderbook.estimateSweep(Side::Sell, 10, 150.0), 0, 0, 0, 0) && ok;
+    ok = checkSweep("sell 10 @ 1e300", orderbook.estimateSweep(Side::Sell, 10, 1e300), 0, 0, 0, 0) && ok;
+    ok = checkSweep("sell 10 @ inf", orderbook.estimateSweep(Side::Sell, 10, inf), 0, 0, 0, 0) && ok;
+    ok = checkSweep("sell 1000 @ -inf", orderbook.estimateSweep(Side::Sell, 1000, -inf), 9680.0 / 200, 48.0, 2, 200) && ok;
+    ok = checkSweep("buy 10 @ -1", orderbook.estimateSweep(Side::Buy, 10, -1.0), 0, 0, 0, 0) && ok;
+    ok = checkSweep("buy 10 @ -1e300", orderbook.estimateSweep(Side::Buy, 10, -1e300), 0, 0, 0, 0) && ok;
+    ok = checkSweep("buy 1000 @ 1e300", orderbook.estimateSweep(Side::Buy, 1000, 1e300), 33200.0 / 650, 52.0, 3, 650) && ok;
+    ok = checkSweep("buy 10 @ nan", orderbook.estimateSweep(Side::Buy, 10, std::nan("")), 0, 0, 0, 0) && ok;
+    ok = checkSweep("buy nan @ inf", orderbook.estimateSweep(Side::Buy, std::nan(""), inf), 0, 0, 0, 0) && ok;
+    ok = checkSweep("sell nan @ -inf", orderbook.estimateSweep(Side::Sell, std::nan(""), -inf), 0, 0, 0, 0) && ok;
+    ok = checkSweep("buy inf @ inf", orderbook.estimateSweep(Side::Buy, inf, inf), 33200.0 / 650, 52.0, 3, 650) && ok;
+    ok = checkSweep("buy inf @ 51", orderbook.estimateSweep(Side::Buy, inf, 51.0), 17600.0 / 350, 50.5, 2, 350) && ok;
+    ok = checkSweep("sell inf @ -inf", orderbook.estimateSweep(Side::Sell, inf, -inf), 9680.0 / 200, 48.0, 2, 200) && ok;
+
+    // after a partial fill of the 50.0 level and cancelling the 50.5 level: 30 @ 50.0 + 300 @ 52.0
+    orderbook.newOrder(7, 50.0, 120, Side::Buy);
+    orderbook.cancelOrder(ask_505);
+    ok = checkSweep("buy 400 after cancel", orderbook.estimateSweep(Side::Buy, 400, inf), 17100.0 / 330, 52.0, 2, 330) && ok;
+    ok = checkSweepAgainstMatch("buy 400 @ 99 after cancel", orderbook, Side::Buy, 400, 99.0) && ok;
+
+    // off-grid prices across more than SWEEP_BLOCK levels so whole blocks are consumed
+    // level i holds 10 @ 20.003 + i * tick, level 0 also holds 5 @ 20.007
+    OrderBook deep(tick, max_price);
+    for (int i = 0; i < 100; ++i) {
+        deep.newOrder(10, 20.003 + i * tick, 10, Side::Sell);
+        deep.newOrder(11, 10.003 + i * tick, 10, Side::Buy);
+    }
+    deep.newOrder(12, 20.007, 5, Side::Sell);
+
+    // 15 from level 0, 10 from each of the next 88 levels and 5 from level 89
+    double notional = 5 * 20.007 + 5 * (20.003 + 89 * tick);
+    for (int i = 0; i < 89; ++i) {
+        notional += 10 * (20.003 + i * tick);
+    }
+    ok = checkSweep("deep buy 900", deep.estimateSweep(Side::Buy, 900, inf), notional / 900, 20.003 + 89 * tick, 90, 900) && ok;
+    ok = checkSweepAgainstMatch("deep buy 900 @ 99", deep, Side::Buy, 900, 99.0) && ok;
+
+    // the 70 highest bid levels, 99 down to 30
+    notional = 0.0;
+    for (int i = 30; i < 100; ++i) {
+        notional += 10 * (10.003 + i * tick);
+    }
+    ok = checkSweep("deep sell 700", deep.estimateSweep(Side::Sell, 700, -inf), notional / 700, 10.003 + 30 * tick, 70, 700) && ok;
+    ok = checkSweepAgainstMatch("deep sell 700 @ 0", deep, Side::Sell, 700, 0.0) && ok;
+
+    // fractional volumes with partial fills and cancels, swept to exactly the depth of the first k levels
+    // the summed level volumes drift from the order volumes, so the last level must still agree with match
+    std::mt19937 rng(0);
+    OrderBook fractional(tick, max_price);
+    std::vector<int> ids;
+    for (int i = 0; i < 80; ++i) {
+        bool buy = (i % 2 == 0);
+        double price = (buy ? 40.0 : 45.0) + (rng() % 300) * tick + (rng() % 1000) * 1e-5;
+        ids.push_back(fractional.newOrder(20, price, (rng() % 10000 + 1) / 100.0, buy ? Side::Buy : Side::Sell));
+    }
+    fractional.newOrder(21, 45.05, 37.37, Side::Buy);
+    fractional.newOrder(22, 42.95, 13.13, Side::Sell);
+    fractional.cancelOrder(ids[10]);
+    fractional.cancelOrder(ids[31]);
+
+    int exact_queries = 0;
+    bool exact_ok = true;
+    for (Side side : {Side::Buy, Side::Sell}) {
+        double limit = (side == Side::Buy) ? 99.0 : 0.0;
+        std::vector<PriceLevel>& opp = (side == Side::Buy) ? fractional.asks : fractional.bids;
+        double qty = 0.0;
+        int k = 0;
+        for (int i = 0; i < fractional.num_price_levels; ++i) {
+            int price_idx = (side == Side::Buy) ? i : (fractional.num_price_levels - 1 - i);
+            if (opp[price_idx].isEmpty()) {
+                continue;
+            }
+            for (int idx = opp[price_idx].head(); idx != -1; idx = fractional.pool[idx].next) {
+                qty += fractional.pool[idx].order.volume;
+            }
+            k++;
+
+            // only depths that match leaves exactly at zero, otherwise match carries a remainder into the next level
+            SweepEstimate expected = referenceSweep(fractional, side, qty, limit);
+            if (expected.levels != k) {
+                continue;
+            }
+            SweepEstimate est = fractional.estimateSweep(side, qty, limit);
+            exact_queries++;
+            if (est.levels != expected.levels || est.worst_price != expected.worst_price || est.fillable != expected.fillable
+                || std::fabs(est.vwap - expected.vwap) > 1e-9 * expected.vwap) {
+                exact_ok = checkSweep("fractional exact depth " + std::to_string(k), est, expected.vwap, expected.worst_price, expected.levels, expected.fillable) && exact_ok;
+            }
+        }
+    }
+    std::cout << (exact_ok ? "PASS " : "FAIL ") << "fractional exact depth: " << exact_queries << " queries checked against match\n";
+    ok = exact_ok && ok;
+
+    std::cout << (ok ? "sweepTest1 passed" : "sweepTest1 FAILED") << "\n";
+    return ok;
+}
+
+
+// time estimateSweep on 500 one-tick ask levels starting at 50.00, each holding 10 @ x.xx1,
+// sweeping nearly the whole side so the scan runs through all the levels
+void sweepBench() {
+    double tick = 0.01;
+    double max_price = 100.0;
+    int iterations = 100'000;
+
+    OrderBook orderbook(tick, max_price);
+    for (int i = 0; i < 500; ++i) {
+        orderbook.newOrder(1, 50.001 + i * tick, 10, Side::Sell);
+    }
+
+    double total = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        total += orderbook.estimateSweep(Side::Buy, 4990 + i % 5, std::numeric_limits<double>::infinity()).vwap;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::cout << "estimateSweep: " << ns << " ns per sweep (checksum " << total << ")\n";
+}
+
+
 void priceLevelTest1() {
     double tick = 0.01;
     double max_price = 100.0;
@@ -492,7 +1002,14 @@ void priceLevelTest2() {
 
 
 
-int main() {
+int main(int argc, char** argv) {
     
+    // run with --bench to time estimateSweep instead of running the tests
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        sweepBench();
+        return 0;
+    }
+
     test1();
+    return sweepTest1() ? 0 : 1;
 }
\ No newline at end of file